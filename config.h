@@ -26,4 +26,19 @@
 #define SAT        BIT5
 #define SUN        BIT6
 
+/**
+ * Countdown / stopwatch channels
+ */
+#define _TIMER_CHANNELS     4       // Number of channels, 1~8
+#define _TIMER_MASK         0x0F    // Channel bits in timer registers, one bit per channel
+#define _TIMER_UNIT_SHIFT   11      // Channel value unit is 2^11 ACLK cycles (1/16s)
+                                    // so 16-bit value covers up to ~68 minutes
+
+/**
+ * Host scratchpad in RAM, retained while powered (also in LPM3)
+ * Mapped to I2C offsets _SCRATCHPAD_BASE ~ _SCRATCHPAD_BASE + _SCRATCHPAD_SIZE - 1
+ */
+#define _SCRATCHPAD_BASE    0x40
+#define _SCRATCHPAD_SIZE    64      // Limited by the 256 bytes RAM of G2452
+
 #endif /* CONFIG_H_ */
@@ -9,13 +9,31 @@
 #ifndef FUNCTIONS_H_
 #define FUNCTIONS_H_
 
+void _run_actions();
 void _init_DS();
 void _check_leap_year();
+unsigned char _leap_year(unsigned char year);
+unsigned char _month_days(unsigned char month, unsigned char leap);
+void _time_apply();
 void _time_increment();
 void _time_carry(unsigned char * byte);
 void _check_alarms();
 void _alarm_interrupt();
 void _alarm_reset_interrupt();
+unsigned char _check_BCD(unsigned char offset, unsigned char byte);
+unsigned long _timer_now();
+unsigned long _timer_read(unsigned char ch);
+void _timer_start(unsigned char ch);
+void _timer_stop(unsigned char ch);
+void _timer_control(unsigned char run_bits);
+void _timer_load();
+void _timer_snapshot();
+void _timer_queue_insert(unsigned char ch);
+void _timer_queue_remove(unsigned char ch);
+void _timer_schedule();
+void _timer_expire();
+void _timer_saturate();
+void _timer_interrupt();
 
 /***********************************************
  * Mandatory functions for callback
@@ -10,6 +10,10 @@
  * No license applied. Use as you wish.
  *
  * Data structure is following DS3231.
+ * I2C offsets 0~30 access the data storage,
+ * offsets 0x40~0x7F access the host scratchpad.
+ * Reading other offsets returns 0xFF, writing them is NACKed,
+ * so a master writing past the end of the scratchpad sees its data cut off.
  *
  * Port definition
  *      P1.0            1-Hz output
@@ -17,7 +21,7 @@
  *      P1.3            I2C slave address pin
  *                      High:   0x41 (default)
  *                      Low:    0x43 (= 0x41 | 0x02)
- *      P1.4            Not used (pull down to GND)
+ *      P1.4            Unison timer channel interrupt output
  *      P1.5            Unison alarm interrupt output for all 6 alarms
  *      P1.6, P1.7      USI I2C mode (with pull-up res enabled)
  *      P2.0            Individual alarm interrupt output for Alarm1
@@ -44,22 +48,48 @@ unsigned char _DATA_STORE[31];  // Data storage
                                 // 5: RTC month in BCD
                                 // 6: RTC year in BCD
                                 // 7: RTC century in BCD
+                                    // Writes to 0~7 are buffered and applied together
+                                    // after STOP, within 0.25s
+                                    // An invalid BCD byte is NACKed and discards the buffer
+                                    // A date not in its month (e.g. Feb 30) discards the buffer
                                 // 8~10: Alarm1: minute(BCD), hour(BCD), day(s)(Bit Mask)
                                     // MSB of byte 9 is the match enable bit
+                                    // An invalid BCD byte is NACKed and ends the write,
+                                    // bytes before it in the same write are kept
                                 // 11~16: Same as 8~10 for Alarm2~Alarm3
-                                // 17~25: Not used
+                                // 17: Timer channel run bits, write 1 to start, 0 to stop
+                                    // Bit cleared by itself when a countdown reaches zero
+                                // 18: Timer channel mode bits. 1: countdown, 0: stopwatch
+                                    // Only changeable while the channel is stopped
+                                // 19: Timer channel interrupt enable bits
+                                // 20: Timer channel interrupt flags
+                                // 21: Timer channel select for 22~23
+                                // 22~23: Selected channel value, LSB first, in 1/16s units
+                                    // Countdown: remaining time rounded up. Stopwatch: elapsed time
+                                    // Stopping keeps the fraction of a unit for the next start
+                                    // Reading 22 latches both bytes
+                                    // Writing 23 loads the value (restarts a running channel)
+                                // 24~25: Not used
                                 // 26: Not used
                                 // 27: Not used
                                 // 28: Reserved for general configuration
                                     // BIT7: Dedicated interrupt output for Alarm1~3
                                 // 29: Alarm interrupt enable bits
                                 // 30: Alarm interrupt flags
+unsigned char _SCRATCHPAD[_SCRATCHPAD_SIZE];    // Host scratchpad, I2C offset _SCRATCHPAD_BASE
+
+const unsigned char _BCD_min[8] = {0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00};
+const unsigned char _BCD_max[8] = {0x59, 0x59, 0x23, 0x07, 0x31, 0x12, 0x99, 0x99};
+                                            // Valid BCD range of RTC data 0~7
+unsigned char _TIME_BUFF[8];                // RTC data 0~7 written by master, not applied yet
+unsigned char _time_buff_bits = 0;          // Bytes in _TIME_BUFF written, one bit per byte
 
 const unsigned int _second_div = 8192;      // 1/4 of 1-Hz with a bit tuning
 unsigned int _second_tick = 0;              // Ticker for a second
 unsigned char _is_leap_year = 0;            // Leap year indicator
 
 unsigned char _I2C_data_offset = 0;         // Offset for data accessing in I2C
+unsigned char _I2C_data_none = 0xFF;        // Read from unmapped offsets
 
 unsigned char _RTC_action_bits = 0x00;      // For marking actions in interrupt
                                             // and run the action in the main loop
@@ -68,6 +98,15 @@ unsigned char _RTC_byte_l = 0, _RTC_byte_h = 0; // For calculation use
 unsigned char _in_lpm = 0;                  // LPM indicator
 unsigned char _prev_in_lpm = 0;             // Previous LPM status indicator
 
+unsigned int _timer_epoch = 0;              // Upper word of channel time base, counts Timer_A overflows
+unsigned long _timer_mark[_TIMER_CHANNELS]; // Running channel deadline (countdown)
+                                            // or start time (stopwatch) in ACLK cycles
+unsigned long _timer_value[_TIMER_CHANNELS];    // Channel value while stopped, in ACLK cycles
+const unsigned long _timer_max = (unsigned long)0xFFFF << _TIMER_UNIT_SHIFT;
+                                            // Stopwatch saturation, 0xFFFF channel units
+unsigned char _timer_queue[_TIMER_CHANNELS];    // Running countdown channels sorted by deadline
+unsigned char _timer_queue_len = 0;         // Number of channels in the deadline queue
+
 /***********************************************
  * Callback related variables (Mandatory)
  * Do not change the variable name
@@ -87,13 +126,14 @@ void main(void) {
     DCOCTL = CALDCO_1MHZ;
 
     // Setup P1 pin directions
-    P1DIR |= (BIT0 + BIT5);             // P1.0 for 1-Hz output
+    P1DIR |= (BIT0 + BIT4 + BIT5);      // P1.0 for 1-Hz output
+                                        // P1.4 as unison timer channel interrupt output pin
                                         // P1.5 as unison alarm interrupt output pin
-    P1OUT &= ~(BIT0 + BIT5);            // P1.0, P1.5 are low initially
+    P1OUT &= ~(BIT0 + BIT4 + BIT5);     // P1.0, P1.4, P1.5 are low initially
     // Enable pull resistors for other pins
-    P1REN |= (BIT1 + BIT2 + BIT3 + BIT4 + BIT6 + BIT7);
+    P1REN |= (BIT1 + BIT2 + BIT3 + BIT6 + BIT7);
     P1OUT |= (BIT3 + BIT6 + BIT7);      // Using pull-up resistor on P1.3, P1.6, P1.7
-    P1OUT &= ~(BIT1 + BIT2 + BIT4);     // Using pull-down resistor on P1.1, P1.2, P1.4
+    P1OUT &= ~(BIT1 + BIT2);            // Using pull-down resistor on P1.1, P1.2
 
     // Set P2.0~P2.2 as dedicated output for alarm1~3
     P2DIR |= (BIT0 + BIT1 + BIT2);
@@ -109,8 +149,7 @@ void main(void) {
     // Initialize data store values
     _init_DS();
     // Check leap year with initial data
-    // Useless for 1st power up
-    //_check_leap_year();
+    _check_leap_year();
 
     // Set LPM indicator at 1st power up
     // and align previous LPM indicator
@@ -122,8 +161,9 @@ void main(void) {
     _prev_in_lpm = _in_lpm;
 
     // Setup Timer
-    TACTL |= (TASSEL_1 + MC_2); // TASSELx = 01, using ACLK as source
-                                // MCx = 02, continuous mode
+    TACTL |= (TASSEL_1 + MC_2 + TAIE);  // TASSELx = 01, using ACLK as source
+                                        // MCx = 02, continuous mode
+                                        // TAIE, count overflows for timer channel time base
 
     TACCR0 = _second_div;       // The timer clock is 32768-Hz
                                 // _second_div is 32768-Hz / 4
@@ -148,7 +188,7 @@ void main(void) {
             _prev_in_lpm = _in_lpm;
             if (_in_lpm) {
                 // Set output pin low
-                P1OUT &= ~(BIT0 + BIT5);
+                P1OUT &= ~(BIT0 + BIT4 + BIT5);
                 P2OUT &= ~(BIT0 + BIT1 + BIT2);
 
                 // Reset USI registers
@@ -162,25 +202,11 @@ void main(void) {
                     USI_I2C_slave_init(_I2C_addr);
                 else
                     USI_I2C_slave_init(_I2C_addr_op1);
+                _RTC_action_bits |= BIT6;   // Restore timer channel interrupt output
             }
         }
 
-        if (_RTC_action_bits & BIT0) {  // The main timer increment
-            _time_increment();
-            _RTC_action_bits &= ~BIT0;
-        }
-        if (_RTC_action_bits & BIT3) {  // Check alarm logic
-            _check_alarms();
-            _RTC_action_bits &= ~BIT3;
-        }
-        if (_RTC_action_bits & BIT4) {  // Check alarm interrupt
-            _alarm_interrupt();
-            _RTC_action_bits &= ~BIT4;
-        }
-        if (_RTC_action_bits & BIT5) {  // Reset alarm interrupt output
-            _alarm_reset_interrupt();
-            _RTC_action_bits &= ~BIT5;
-        }
+        _run_actions();
     }
 }
 
@@ -188,6 +214,36 @@ void main(void) {
  * Extra functions
  */
 
+/**
+ * Run actions marked in interrupts
+ */
+void _run_actions() {
+    if (_RTC_action_bits & BIT1) {  // Apply time written by master
+        _time_apply();
+        _RTC_action_bits &= ~BIT1;
+    }
+    if (_RTC_action_bits & BIT0) {  // The main timer increment
+        _time_increment();
+        _RTC_action_bits &= ~BIT0;
+    }
+    if (_RTC_action_bits & BIT3) {  // Check alarm logic
+        _check_alarms();
+        _RTC_action_bits &= ~BIT3;
+    }
+    if (_RTC_action_bits & BIT4) {  // Check alarm interrupt
+        _alarm_interrupt();
+        _RTC_action_bits &= ~BIT4;
+    }
+    if (_RTC_action_bits & BIT5) {  // Reset alarm interrupt output
+        _alarm_reset_interrupt();
+        _RTC_action_bits &= ~BIT5;
+    }
+    if (_RTC_action_bits & BIT6) {  // Update timer channel interrupt output
+        _timer_interrupt();
+        _RTC_action_bits &= ~BIT6;
+    }
+}
+
 /**
  * Initialize data store values
  */
@@ -203,17 +259,65 @@ void _init_DS() {
  * Check whether current year is leap year
  */
 void _check_leap_year() {
-    // Reset leap year indicator first
-    _is_leap_year = 0;
+    _is_leap_year = _leap_year(_DATA_STORE[6]);
+}
 
-    _RTC_byte_l = _DATA_STORE[6] << 4;
-    if (_DATA_STORE[6] & 0x10) {
-        if (_RTC_byte_l == 0x20 || _RTC_byte_l == 0x60)
-            _is_leap_year = 1;
-    } else {
-        if (_RTC_byte_l == 0x40 || _RTC_byte_l == 0x80)
-            _is_leap_year = 1;
+/**
+ * Check whether a BCD year is leap year
+ */
+unsigned char _leap_year(unsigned char year) {
+    unsigned char year_l = year << 4;
+
+    if (year & 0x10)    // Odd tens, 12, 16, 32, ...
+        return (year_l == 0x20 || year_l == 0x60);
+    else                // Even tens, 00, 04, 08, 20, ...
+        return (year_l == 0x00 || year_l == 0x40 || year_l == 0x80);
+}
+
+/**
+ * Number of days of a month in BCD
+ */
+unsigned char _month_days(unsigned char month, unsigned char leap) {
+    switch (month) {
+    case 0x02:
+        return leap ? 0x29 : 0x28;
+    case 0x04:
+    case 0x06:
+    case 0x09:
+    case 0x11:
+        return 0x30;
+    default:
+        return 0x31;
+    }
+}
+
+/**
+ * Apply buffered time written by master after STOP
+ * The whole buffer is discarded if the resulting date does not exist
+ */
+void _time_apply() {
+    unsigned char time[8];
+    unsigned char i;
+
+    __disable_interrupt();          // Buffer is written in USI interrupt
+    for (i = 0; i < 8; i++) {
+        if (_time_buff_bits & (1 << i))
+            time[i] = _TIME_BUFF[i];
+        else
+            time[i] = _DATA_STORE[i];
     }
+    _time_buff_bits = 0;
+    __enable_interrupt();
+
+    for (i = 0; i < 8; i++)
+        if (_check_BCD(i, time[i]))
+            return;
+    if (time[4] > _month_days(time[5], _leap_year(time[6])))
+        return;
+
+    for (i = 0; i < 8; i++)
+        _DATA_STORE[i] = time[i];
+    _check_leap_year();
 }
 
 /**
@@ -424,6 +528,251 @@ void _alarm_reset_interrupt() {
     P2OUT &= ~(BIT0 + BIT1 + BIT2);
 }
 
+/**
+ * Check whether a byte written by master keeps time and alarm data valid BCD
+ * Returns 0 when valid
+ */
+unsigned char _check_BCD(unsigned char offset, unsigned char byte) {
+    unsigned char min = 0x00, max = 0xFF;
+
+    if (offset < 8) {                   // RTC data
+        min = _BCD_min[offset];
+        max = _BCD_max[offset];
+    } else if (offset < 17) {           // Alarm data
+        switch ((offset - 8) % 3) {
+        case 0:     // Minute
+            max = 0x59;
+            break;
+        case 1:     // Hour, MSB is the match enable bit
+            byte &= 0x7F;
+            max = 0x23;
+            break;
+        default:    // Day mask, not BCD
+            return 0;
+        }
+    } else {
+        return 0;
+    }
+
+    if ((byte & 0x0F) > 0x09 || byte < min || byte > max)
+        return 1;
+    return 0;
+}
+
+/**
+ * Read the channel time base in ACLK cycles
+ * Only called from interrupt context (interrupts disabled)
+ */
+unsigned long _timer_now() {
+    unsigned int tar_l, tar_h;
+
+    do {                            // TAR runs on ACLK, asynchronous to MCLK
+        tar_l = TAR;                // Read until two reads agree
+    } while (tar_l != TAR);
+    tar_h = _timer_epoch;
+    if ((TACTL & TAIFG) && !(tar_l & 0x8000))   // Overflow pending but not counted yet
+        tar_h++;
+
+    return ((unsigned long)tar_h << 16) | tar_l;
+}
+
+/**
+ * Current value of a channel in ACLK cycles
+ * Countdown: remaining time. Stopwatch: elapsed time, saturated.
+ */
+unsigned long _timer_read(unsigned char ch) {
+    unsigned long diff;
+
+    if (!(_DATA_STORE[17] & (1 << ch)))     // Stopped, value is frozen
+        return _timer_value[ch];
+
+    if (_DATA_STORE[18] & (1 << ch)) {      // Countdown
+        diff = _timer_mark[ch] - _timer_now();
+        if ((long)diff <= 0)
+            return 0;
+        return diff;
+    } else {                                // Stopwatch
+        diff = _timer_now() - _timer_mark[ch] + _timer_value[ch];
+        if (diff > _timer_max)
+            return _timer_max;
+        return diff;
+    }
+}
+
+/**
+ * Start a stopped channel from its current value
+ */
+void _timer_start(unsigned char ch) {
+    if (_DATA_STORE[18] & (1 << ch)) {      // Countdown, schedule the deadline
+        _timer_mark[ch] = _timer_now() + _timer_value[ch];
+        _timer_queue_insert(ch);
+    } else {                                // Stopwatch, no deadline to schedule
+        _timer_mark[ch] = _timer_now();
+    }
+    _DATA_STORE[17] |= (1 << ch);
+}
+
+/**
+ * Stop a running channel and freeze its value
+ */
+void _timer_stop(unsigned char ch) {
+    _timer_value[ch] = _timer_read(ch);
+    if (_DATA_STORE[18] & (1 << ch))
+        _timer_queue_remove(ch);
+    _DATA_STORE[17] &= ~(1 << ch);
+}
+
+/**
+ * Start or stop channels according to run bits written by master
+ */
+void _timer_control(unsigned char run_bits) {
+    unsigned char ch;
+
+    run_bits &= _TIMER_MASK;
+    for (ch = 0; ch < _TIMER_CHANNELS; ch++) {
+        if ((run_bits & (1 << ch)) && !(_DATA_STORE[17] & (1 << ch)))
+            _timer_start(ch);
+        else if (!(run_bits & (1 << ch)) && (_DATA_STORE[17] & (1 << ch)))
+            _timer_stop(ch);
+    }
+}
+
+/**
+ * Load value in 22~23 to the selected channel
+ */
+void _timer_load() {
+    unsigned char ch = _DATA_STORE[21];
+
+    unsigned long value;
+
+    value = _DATA_STORE[22] | ((unsigned int)_DATA_STORE[23] << 8);
+    value <<= _TIMER_UNIT_SHIFT;
+    if (_DATA_STORE[17] & (1 << ch)) {      // Running, restart from the new value
+        _timer_stop(ch);
+        _timer_value[ch] = value;
+        _timer_start(ch);
+    } else {
+        _timer_value[ch] = value;
+    }
+}
+
+/**
+ * Latch value of the selected channel to 22~23 for reading, in channel units
+ * Countdown rounds up so it only reads 0 once expired
+ */
+void _timer_snapshot() {
+    unsigned char ch = _DATA_STORE[21];
+    unsigned long cycles = _timer_read(ch);
+    unsigned int value;
+
+    if (_DATA_STORE[18] & (1 << ch))
+        cycles += (1 << _TIMER_UNIT_SHIFT) - 1;
+    value = cycles >> _TIMER_UNIT_SHIFT;
+
+    _DATA_STORE[22] = value;
+    _DATA_STORE[23] = value >> 8;
+}
+
+/**
+ * Insert a countdown channel to the deadline queue, keeping it sorted
+ */
+void _timer_queue_insert(unsigned char ch) {
+    unsigned char i = _timer_queue_len;
+
+    while (i && (long)(_timer_mark[ch] - _timer_mark[_timer_queue[i - 1]]) < 0) {
+        _timer_queue[i] = _timer_queue[i - 1];
+        i--;
+    }
+    _timer_queue[i] = ch;
+    _timer_queue_len++;
+
+    if (!i)     // New earliest deadline
+        _timer_schedule();
+}
+
+/**
+ * Remove a countdown channel from the deadline queue
+ */
+void _timer_queue_remove(unsigned char ch) {
+    unsigned char i, j;
+
+    for (i = 0; i < _timer_queue_len; i++)
+        if (_timer_queue[i] == ch)
+            break;
+    if (i == _timer_queue_len)
+        return;
+
+    _timer_queue_len--;
+    for (j = i; j < _timer_queue_len; j++)
+        _timer_queue[j] = _timer_queue[j + 1];
+
+    if (!i)     // Earliest deadline changed
+        _timer_schedule();
+}
+
+/**
+ * Program TACCR1 with the earliest deadline only
+ * Deadlines beyond one Timer_A period are left unarmed,
+ * the overflow interrupt calls this again every period
+ */
+void _timer_schedule() {
+    if (!_timer_queue_len ||
+            _timer_mark[_timer_queue[0]] - _timer_now() >= 0x10000) {
+        TACCTL1 = 0;                // Nothing to wait for in this period
+        return;
+    }
+
+    TACCR1 = (unsigned int)_timer_mark[_timer_queue[0]];
+    TACCTL1 = CCIE;                 // Enable compare interrupt, clear pending flag
+    if ((long)(_timer_mark[_timer_queue[0]] - _timer_now()) <= 0)
+        TACCTL1 |= CCIFG;           // Already due, do not wait for the compare match
+}
+
+/**
+ * Expire all due channels at the head of the deadline queue
+ */
+void _timer_expire() {
+    unsigned long now = _timer_now();
+    unsigned char ch;
+
+    while (_timer_queue_len &&
+            (long)(_timer_mark[_timer_queue[0]] - now) <= 0) {
+        ch = _timer_queue[0];
+        _timer_queue_remove(ch);
+        _timer_value[ch] = 0;
+        _DATA_STORE[17] &= ~(1 << ch);  // Countdown stops at zero
+        _DATA_STORE[20] |= (1 << ch);   // Set interrupt flag
+    }
+    _timer_schedule();
+}
+
+/**
+ * Freeze running stopwatches at 0xFFFF units before the 32-bit time base wraps
+ * Called on every Timer_A overflow (2s)
+ */
+void _timer_saturate() {
+    unsigned char ch;
+
+    for (ch = 0; ch < _TIMER_CHANNELS; ch++) {
+        if ((_DATA_STORE[17] & (1 << ch)) &&
+                !(_DATA_STORE[18] & (1 << ch)) &&
+                _timer_read(ch) == _timer_max) {
+            _timer_value[ch] = _timer_max;  // Keep saturated value
+            _timer_mark[ch] = _timer_now(); // and restart the elapsed count from now
+        }
+    }
+}
+
+/**
+ * Set timer channel interrupt output while any enabled flag is set
+ */
+void _timer_interrupt() {
+    if (!_in_lpm && (_DATA_STORE[19] & _DATA_STORE[20]))
+        P1OUT |= BIT4;
+    else
+        P1OUT &= ~BIT4;
+}
+
 /***********************************************
  * Mandatory functions for callback
  * You can modify codes in these functions
@@ -435,6 +784,15 @@ unsigned char * USI_I2C_slave_TX_callback() {
     unsigned char _I2C_data_offset_1;
     _I2C_data_offset_1 = _I2C_data_offset;
     _I2C_data_offset++;
+    if (_I2C_data_offset_1 >= _SCRATCHPAD_BASE) {   // Streaming scratchpad first
+        if (_I2C_data_offset_1 < _SCRATCHPAD_BASE + _SCRATCHPAD_SIZE)
+            return _SCRATCHPAD + (_I2C_data_offset_1 - _SCRATCHPAD_BASE);
+        return &_I2C_data_none;
+    }
+    if (_I2C_data_offset_1 >= 31)
+        return &_I2C_data_none;
+    if (_I2C_data_offset_1 == 22)   // Latch selected timer channel value
+        _timer_snapshot();
     return _DATA_STORE + _I2C_data_offset_1;
 }
 
@@ -445,29 +803,49 @@ unsigned char USI_I2C_slave_RX_callback(unsigned char * byte) {
         _I2C_data_offset = byte_data;
         _USI_I2C_slave_n_byte = 1;
     } else {
-        if (_I2C_data_offset != 26 &&
+        if (_I2C_data_offset < 17 &&
+                _check_BCD(_I2C_data_offset, byte_data)) {
+            if (_I2C_data_offset < 8)
+                _time_buff_bits = 0;    // Discard buffered time
+            return 1;                   // Invalid time or alarm data, NACK and keep old value
+        }
+        if (_I2C_data_offset >= _SCRATCHPAD_BASE) {     // Streaming scratchpad first
+            if (_I2C_data_offset >= _SCRATCHPAD_BASE + _SCRATCHPAD_SIZE)
+                return 1;               // Unmapped offset, NACK
+            _SCRATCHPAD[_I2C_data_offset - _SCRATCHPAD_BASE] = byte_data;
+        } else if (_I2C_data_offset < 8) {              // Time is applied after STOP
+            _TIME_BUFF[_I2C_data_offset] = byte_data;
+            _time_buff_bits |= (1 << _I2C_data_offset);
+        } else if (_I2C_data_offset >= 31) {
+            return 1;                   // Unmapped offset, NACK
+        } else if (_I2C_data_offset != 26 &&
                 _I2C_data_offset != 27) {
             switch(_I2C_data_offset) {
             case 30:    // Do not allow 1 for alarm interrupt flags when flags are 0
-                if (!(_DATA_STORE[30] & BIT0) &&
-                        (byte_data & BIT0))
-                    byte_data &= ~BIT0;
-                if (!(_DATA_STORE[30] & BIT1) &&
-                        (byte_data & BIT1))
-                    byte_data &= ~BIT1;
-                if (!(_DATA_STORE[30] & BIT2) &&
-                        (byte_data & BIT2))
-                    byte_data &= ~BIT2;
-                if (!(_DATA_STORE[30] & BIT3) &&
-                        (byte_data & BIT3))
-                    byte_data &= ~BIT3;
-                if (!(_DATA_STORE[30] & BIT4) &&
-                        (byte_data & BIT4))
-                    byte_data &= ~BIT4;
-                if (!(_DATA_STORE[30] & BIT5) &&
-                        (byte_data & BIT5))
-                    byte_data &= ~BIT5;
-                _DATA_STORE[30] = byte_data;
+                _DATA_STORE[30] &= byte_data;
+                break;
+            case 17:    // Start or stop timer channels
+                _timer_control(byte_data);
+                break;
+            case 18:    // Mode of running timer channels is kept
+                _DATA_STORE[18] = ((byte_data & ~_DATA_STORE[17]) |
+                        (_DATA_STORE[18] & _DATA_STORE[17])) & _TIMER_MASK;
+                break;
+            case 19:
+                _DATA_STORE[19] = byte_data & _TIMER_MASK;
+                _RTC_action_bits |= BIT6;   // Update timer channel interrupt output
+                break;
+            case 20:    // Timer channel interrupt flags can only be cleared
+                _DATA_STORE[20] &= byte_data;
+                _RTC_action_bits |= BIT6;   // Update timer channel interrupt output
+                break;
+            case 21:
+                if (byte_data < _TIMER_CHANNELS)
+                    _DATA_STORE[21] = byte_data;
+                break;
+            case 23:
+                _DATA_STORE[23] = byte_data;
+                _timer_load();
                 break;
             default:
                 *(_DATA_STORE + _I2C_data_offset) = byte_data;
@@ -499,6 +877,10 @@ __interrupt void Timer_A0(void) {
 
     TACCR0 += _second_div;
 
+    // Apply buffered time once the master has sent STOP
+    if (_time_buff_bits && ((USICTL1 & USISTP) || _in_lpm))
+        _RTC_action_bits |= BIT1;
+
     _second_tick++; // Increment the ticker
     switch (_second_tick) {
     case 1:
@@ -522,3 +904,25 @@ __interrupt void Timer_A0(void) {
         _second_tick = 0;   // Reset ticker
     }
 }
+
+/**
+ * Timer channel deadline and Timer_A overflow interrupt
+ */
+#pragma vector=TIMER0_A1_VECTOR
+__interrupt void Timer_A1(void) {
+    switch (TA0IV) {
+    case TA0IV_TACCR1:  // Earliest timer channel deadline
+        _timer_expire();
+        if (_DATA_STORE[19] & _DATA_STORE[20]) {
+            _RTC_action_bits |= BIT6;   // Let's set timer channel interrupt output
+            _BIC_SR_IRQ(LPM3_bits);     // Exit LPM3
+        }
+        break;
+    case TA0IV_TAIFG:   // Extend channel time base
+        _timer_epoch++;
+        _timer_saturate();
+        if (!(TACCTL1 & CCIE))
+            _timer_schedule();          // Arm a deadline coming in this period
+        break;
+    }
+}
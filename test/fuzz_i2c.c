@@ -0,0 +1,165 @@
+/*
+ * Fuzz the I2C register protocol with arbitrary bus traffic
+ *
+ * Each input byte is an operation, low 3 bits select it:
+ *      0       START (also in the middle of a byte or burst)
+ *      1       STOP
+ *      2       Write the next input byte
+ *      3       Read a byte and ACK
+ *      4       Read a byte and NACK
+ *      5       Advance time by (byte >> 3) + 1 timer events
+ *      6       Write the next (byte >> 3) input bytes as a burst
+ *      7       START and address the slave, BIT3 selects read
+ * Invariants are checked after every operation, flags are also checked
+ * across every time step, out-of-bounds accesses are caught by
+ * AddressSanitizer.
+ *
+ * Built with -fsanitize=fuzzer this is a libFuzzer target,
+ * otherwise main() runs files given as arguments or random inputs.
+ *
+ * No license applied. Use as you wish.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host.h"
+
+static void fail(const unsigned char * data, unsigned long size, unsigned long at) {
+    unsigned long i;
+
+    fprintf(stderr, "Invariant broken at operation %lu: %s\nInput:", at, host_violation);
+    for (i = 0; i < size; i++)
+        fprintf(stderr, " %02x", data[i]);
+    fprintf(stderr, "\n");
+    abort();
+}
+
+int LLVMFuzzerTestOneInput(const unsigned char * data, size_t size) {
+    unsigned long i = 0, at;
+    unsigned char op, n;
+
+    host_reset();
+    while (i < size) {
+        at = i;
+        op = data[i++];
+        switch (op & 0x07) {
+        case 0:
+            i2c_start();
+            break;
+        case 1:
+            i2c_stop();
+            break;
+        case 2:
+            if (i < size)
+                i2c_write(data[i++]);
+            break;
+        case 3:
+            i2c_read(0);
+            break;
+        case 4:
+            i2c_read(1);
+            break;
+        case 5:
+            for (n = (op >> 3) + 1; n; n--)
+                host_tick();
+            break;
+        case 6:
+            for (n = op >> 3; n && i < size; n--)
+                i2c_write(data[i++]);
+            break;
+        case 7:
+            i2c_start();
+            i2c_write((op & 0x08) ? HOST_ADDR_R : HOST_ADDR_W);
+            break;
+        }
+        if (host_check())
+            fail(data, size, at);
+    }
+
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+static unsigned long seed = 2463534242UL;
+
+static unsigned char random_byte() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed & 0xFF;
+}
+
+/**
+ * Random input mixing raw bus operations with whole register transactions,
+ * so timer channels and time writes are reached without a coverage guide
+ */
+static unsigned long random_input(unsigned char * input, unsigned long max) {
+    unsigned long n = 0;
+    unsigned char k;
+
+    while (n + 16 < max && random_byte() > 4) {
+        switch (random_byte() & 0x03) {
+        case 0:     // Raw operation
+            input[n++] = random_byte();
+            input[n++] = random_byte();
+            break;
+        case 1:     // Write registers
+            input[n++] = 0x07;
+            input[n++] = 0x02;
+            input[n++] = random_byte() & (random_byte() & 0x01 ? 0x7F : 0x1F);
+            k = (random_byte() & 0x07) + 1;
+            input[n++] = 0x06 | (k << 3);
+            while (k--)
+                input[n++] = random_byte() & random_byte();    // Favour small values
+            input[n++] = 0x01;
+            break;
+        case 2:     // Read registers
+            input[n++] = 0x07;
+            input[n++] = 0x02;
+            input[n++] = random_byte() & 0x1F;
+            input[n++] = 0x0F;
+            input[n++] = 0x03;
+            input[n++] = 0x04;
+            input[n++] = 0x01;
+            break;
+        default:    // Time passes
+            input[n++] = 0x05 | (random_byte() & 0xF8);
+        }
+    }
+
+    return n;
+}
+
+int main(int argc, char ** argv) {
+    static unsigned char input[512];
+    unsigned long runs = 20000, size, r, i;
+    FILE * f;
+
+    if (argc > 1 && argv[1][0] != '-') {    // Replay inputs
+        for (i = 1; i < (unsigned long)argc; i++) {
+            f = fopen(argv[i], "rb");
+            if (!f) {
+                perror(argv[i]);
+                return 1;
+            }
+            size = fread(input, 1, sizeof(input), f);
+            fclose(f);
+            LLVMFuzzerTestOneInput(input, size);
+        }
+        printf("fuzz_i2c: %d inputs replayed\n", argc - 1);
+        return 0;
+    }
+    if (argc > 1)
+        runs = strtoul(argv[1] + 1, 0, 10);
+
+    for (r = 0; r < runs; r++) {
+        size = random_input(input, sizeof(input));
+        LLVMFuzzerTestOneInput(input, size);
+    }
+    printf("fuzz_i2c: %lu random inputs passed\n", runs);
+
+    return 0;
+}
+#endif
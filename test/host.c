@@ -0,0 +1,372 @@
+/*
+ * Host build of the firmware: I2C master and Timer_A emulation
+ *
+ * The USI is modelled at byte level: whenever the firmware loads USICNT,
+ * the next master operation shifts that many bits through USISRL,
+ * wired-AND with the slave output when USIOE is set, then raises USIIFG
+ * and calls USI_INT. Timer_A counts in ACLK cycles and jumps from one
+ * compare or overflow event to the next.
+ *
+ * No license applied. Use as you wish.
+ */
+
+#include <string.h>
+
+#include <msp430.h>
+
+#include "../config.h"
+#include "host.h"
+
+/* Peripheral registers */
+volatile unsigned short WDTCTL;
+volatile unsigned char BCSCTL1, BCSCTL3, DCOCTL;
+volatile unsigned char CALBC1_1MHZ, CALDCO_1MHZ;
+volatile unsigned char P1IN, P1OUT, P1DIR, P1REN;
+volatile unsigned char P2IN, P2OUT, P2DIR, P2REN;
+volatile unsigned short TACTL, TAR, TA0IV;
+volatile unsigned short TACCTL0, TACCTL1, TACCR0, TACCR1;
+volatile unsigned char USICTL0, USICTL1, USICKCTL, USICNT, USISRL;
+
+/* Firmware entry points */
+void USI_INT(void);
+void Timer_A0(void);
+void Timer_A1(void);
+void USI_I2C_slave_init(unsigned char USI_I2C_slave_OA);
+void _init_DS();
+void _check_leap_year();
+void _run_actions();
+
+/* Firmware state, long is built as int (see Makefile) */
+extern unsigned char _DATA_STORE[31];
+extern unsigned char _SCRATCHPAD[_SCRATCHPAD_SIZE];
+extern unsigned char _TIME_BUFF[8];
+extern unsigned char _time_buff_bits;
+extern unsigned int _second_tick;
+extern unsigned char _is_leap_year;
+extern unsigned char _I2C_data_offset;
+extern unsigned char _I2C_data_none;
+extern unsigned char _RTC_action_bits;
+extern unsigned char _RTC_byte_l, _RTC_byte_h;
+extern unsigned char _in_lpm, _prev_in_lpm;
+extern unsigned int _timer_epoch;
+extern unsigned int _timer_mark[_TIMER_CHANNELS];
+extern unsigned int _timer_value[_TIMER_CHANNELS];
+extern unsigned char _timer_queue[_TIMER_CHANNELS];
+extern unsigned char _timer_queue_len;
+extern unsigned char _USI_I2C_slave_n_byte;
+extern unsigned char _USI_I2C_slave_state;
+
+unsigned long host_ccr1_count;
+const char * host_violation;
+
+/**
+ * Bring firmware and peripherals to the state after power up and I2C init
+ */
+void host_reset() {
+    WDTCTL = 0;
+    P1IN = BIT3;            // Default slave address
+    P2IN = BIT5;            // Not in LPM
+    P1OUT = P1DIR = P1REN = 0;
+    P2OUT = P2DIR = P2REN = 0;
+    TACTL = TAR = TA0IV = 0;
+    TACCTL0 = TACCTL1 = TACCR0 = TACCR1 = 0;
+    USICTL0 = USICTL1 = USICKCTL = USICNT = USISRL = 0;
+
+    memset(_DATA_STORE, 0, sizeof(_DATA_STORE));
+    memset(_SCRATCHPAD, 0, sizeof(_SCRATCHPAD));
+    memset(_TIME_BUFF, 0, sizeof(_TIME_BUFF));
+    memset(_timer_mark, 0, sizeof(_timer_mark));
+    memset(_timer_value, 0, sizeof(_timer_value));
+    memset(_timer_queue, 0, sizeof(_timer_queue));
+    _time_buff_bits = 0;
+    _second_tick = 0;
+    _I2C_data_offset = 0;
+    _I2C_data_none = 0xFF;
+    _RTC_action_bits = 0;
+    _RTC_byte_l = _RTC_byte_h = 0;
+    _in_lpm = _prev_in_lpm = 0;
+    _timer_epoch = 0;
+    _timer_queue_len = 0;
+    _USI_I2C_slave_n_byte = 0;
+    _USI_I2C_slave_state = 0;
+
+    host_ccr1_count = 0;
+    host_violation = 0;
+
+    // Same order as main()
+    _init_DS();
+    _check_leap_year();
+    TACTL |= (TASSEL_1 + MC_2 + TAIE);
+    TACCR0 = 8192;
+    TACCTL0 |= CCIE;
+    USI_I2C_slave_init(0x41);
+}
+
+/**
+ * Shift bits while the firmware has USICNT loaded
+ * Returns the bus value, 0xFF when the slave does not clock the bus
+ */
+static unsigned char usi_shift(unsigned char master) {
+    unsigned char n = USICNT & 0x1F;
+    unsigned char bus = 0, bit;
+
+    if (!n)
+        return 0xFF;
+
+    while (n) {
+        n--;
+        bit = (master >> n) & 1;
+        if (USICTL0 & USIOE)                // Open drain, slave may pull low
+            bit &= USISRL >> 7;
+        USISRL = (USISRL << 1) | bit;
+        bus = (bus << 1) | bit;
+    }
+    USICNT &= ~0x1F;
+    USICTL1 |= USIIFG;
+    USI_INT();
+
+    return bus;
+}
+
+/**
+ * Flags may only be cleared by the master
+ */
+static void check_flags(unsigned char flags_20, unsigned char flags_30) {
+    if (!host_violation && (_DATA_STORE[20] & ~flags_20))
+        host_violation = "timer channel flag set by master";
+    if (!host_violation && (_DATA_STORE[30] & ~flags_30))
+        host_violation = "alarm flag set by master";
+}
+
+/**
+ * Firmware activity may set flags but never clears them
+ */
+static void check_flags_kept(unsigned char flags_20, unsigned char flags_30) {
+    if (!host_violation && (flags_20 & ~_DATA_STORE[20]))
+        host_violation = "timer channel flag cleared without master";
+    if (!host_violation && (flags_30 & ~_DATA_STORE[30]))
+        host_violation = "alarm flag cleared without master";
+}
+
+void i2c_start() {
+    USICTL1 |= USISTTIFG;
+    USI_INT();
+}
+
+void i2c_stop() {
+    USICTL1 |= USISTP;
+}
+
+unsigned char i2c_write(unsigned char byte) {
+    unsigned char flags_20 = _DATA_STORE[20], flags_30 = _DATA_STORE[30];
+    unsigned char nack;
+
+    usi_shift(byte);
+    nack = usi_shift(0x01) & 1;     // Master releases SDA for ACKNACK
+    check_flags(flags_20, flags_30);
+
+    return nack;
+}
+
+unsigned char i2c_read(unsigned char nack) {
+    unsigned char flags_20 = _DATA_STORE[20], flags_30 = _DATA_STORE[30];
+    unsigned char byte;
+
+    byte = usi_shift(0xFF);         // Master releases SDA
+    usi_shift(nack ? 0x01 : 0x00);
+    check_flags(flags_20, flags_30);
+
+    return byte;
+}
+
+unsigned char i2c_write_regs(unsigned char offset, const unsigned char * data, unsigned char n) {
+    unsigned char i = 0;
+
+    i2c_start();
+    if (!i2c_write(HOST_ADDR_W) && !i2c_write(offset))
+        for (i = 0; i < n; i++)
+            if (i2c_write(data[i]))
+                break;
+    i2c_stop();
+
+    return i;
+}
+
+void i2c_read_regs(unsigned char offset, unsigned char * data, unsigned char n) {
+    unsigned char i;
+
+    i2c_start();
+    i2c_write(HOST_ADDR_W);
+    i2c_write(offset);
+    i2c_start();                    // Repeated START
+    i2c_write(HOST_ADDR_R);
+    for (i = 0; i < n; i++)
+        data[i] = i2c_read(i == n - 1);
+    i2c_stop();
+}
+
+/**
+ * ACLK cycles to the next Timer_A event, 0 when an interrupt is pending
+ */
+static unsigned long next_event() {
+    unsigned long d0, d1, dov, d;
+    unsigned short tar = TAR;
+
+    if ((TACCTL1 & CCIFG) && (TACCTL1 & CCIE))
+        return 0;
+
+    d0 = (unsigned short)(TACCR0 - tar);
+    if (!d0)
+        d0 = 0x10000;
+    d1 = (unsigned short)(TACCR1 - tar);
+    if (!d1 || !(TACCTL1 & CCIE))
+        d1 = 0x10000;
+    dov = 0x10000 - tar;
+    d = d0 < d1 ? d0 : d1;
+    return d < dov ? d : dov;
+}
+
+/**
+ * Advance Timer_A to its next event, serve interrupts and run main loop actions
+ */
+void host_tick() {
+    unsigned char flags_20 = _DATA_STORE[20], flags_30 = _DATA_STORE[30];
+    unsigned long d = next_event();
+    unsigned short tar = TAR;
+
+    if (d) {                        // Nothing pending from software, wait for next event
+        TAR = tar + d;
+        if (d == (unsigned short)(TACCR0 - tar) || (d == 0x10000 && TACCR0 == tar))
+            TACCTL0 |= CCIFG;
+        if ((TACCTL1 & CCIE) && (d == (unsigned short)(TACCR1 - tar) ||
+                (d == 0x10000 && TACCR1 == tar)))
+            TACCTL1 |= CCIFG;
+        if (d == 0x10000 - tar)
+            TACTL |= TAIFG;
+    }
+
+    if (TACCTL0 & CCIFG) {
+        TACCTL0 &= ~CCIFG;
+        Timer_A0();
+    }
+    while (((TACCTL1 & CCIFG) && (TACCTL1 & CCIE)) ||
+            ((TACTL & TAIFG) && (TACTL & TAIE))) {
+        if ((TACCTL1 & CCIFG) && (TACCTL1 & CCIE)) {
+            TACCTL1 &= ~CCIFG;
+            TA0IV = TA0IV_TACCR1;
+            host_ccr1_count++;
+        } else {
+            TACTL &= ~TAIFG;
+            TA0IV = TA0IV_TAIFG;
+        }
+        Timer_A1();
+    }
+
+    _run_actions();
+    check_flags_kept(flags_20, flags_30);
+}
+
+void host_run_cycles(unsigned long cycles) {
+    unsigned long d;
+
+    while (cycles) {
+        d = next_event();
+        if (d > cycles) {           // No event before the end, just count
+            TAR += cycles;
+            return;
+        }
+        cycles -= d;
+        host_tick();
+    }
+}
+
+void host_run_seconds(unsigned long seconds) {
+    unsigned long ticks = seconds * 4;
+    unsigned short ccr0;
+
+    // Each second has 4 compare events, plus overflows and channel deadlines
+    while (ticks) {
+        ccr0 = TACCR0;
+        host_tick();
+        if (TACCR0 != ccr0)
+            ticks--;
+    }
+}
+
+/**
+ * BCD byte to number, -1 when not BCD
+ */
+static int bcd(unsigned char byte) {
+    if ((byte & 0x0F) > 9 || (byte >> 4) > 9)
+        return -1;
+    return (byte >> 4) * 10 + (byte & 0x0F);
+}
+
+static int in_range(unsigned char byte, int min, int max) {
+    int n = bcd(byte);
+    return n >= min && n <= max;
+}
+
+int host_check() {
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int year, month, date_max, i, j;
+    unsigned char ch;
+
+    if (host_violation)
+        return 1;
+
+    // Time is always valid BCD and the date exists
+    if (!in_range(_DATA_STORE[0], 0, 59) || !in_range(_DATA_STORE[1], 0, 59) ||
+            !in_range(_DATA_STORE[2], 0, 23) || !in_range(_DATA_STORE[3], 1, 7) ||
+            !in_range(_DATA_STORE[5], 1, 12) || !in_range(_DATA_STORE[6], 0, 99) ||
+            !in_range(_DATA_STORE[7], 0, 99))
+        host_violation = "time is not valid BCD";
+    else {
+        year = bcd(_DATA_STORE[6]);
+        month = bcd(_DATA_STORE[5]);
+        date_max = days[month - 1] + (month == 2 && !(year % 4));
+        if (!in_range(_DATA_STORE[4], 1, date_max))
+            host_violation = "date does not exist in month";
+        else if (_is_leap_year != !(year % 4))
+            host_violation = "leap year indicator out of date";
+    }
+
+    // Alarm minute and hour are valid BCD
+    for (i = 8; !host_violation && i < 17; i += 3)
+        if (!in_range(_DATA_STORE[i], 0, 59))
+            host_violation = "alarm minute is not valid BCD";
+        else if (!in_range(_DATA_STORE[i + 1] & 0x7F, 0, 23))
+            host_violation = "alarm hour is not valid BCD";
+
+    // Bus state machine only takes known states
+    switch (_USI_I2C_slave_state) {
+    case 0: case 2: case 3: case 6:
+    case 11: case 12: case 13: case 14: case 15:
+        break;
+    default:
+        if (!host_violation)
+            host_violation = "unknown USI state";
+    }
+    if (!host_violation && _I2C_data_none != 0xFF)
+        host_violation = "unmapped read byte modified";
+
+    // Timer channel registers and deadline queue
+    if (!host_violation && ((_DATA_STORE[17] | _DATA_STORE[18] | _DATA_STORE[19] | _DATA_STORE[20]) & ~_TIMER_MASK))
+        host_violation = "timer channel bits out of mask";
+    if (!host_violation && _DATA_STORE[21] >= _TIMER_CHANNELS)
+        host_violation = "timer channel select out of range";
+    if (!host_violation && _timer_queue_len > _TIMER_CHANNELS)
+        host_violation = "deadline queue overflow";
+    for (ch = 0; !host_violation && ch < _TIMER_CHANNELS; ch++) {
+        j = 0;
+        for (i = 0; i < _timer_queue_len; i++)
+            j += (_timer_queue[i] == ch);
+        if (j != ((_DATA_STORE[17] & _DATA_STORE[18] & (1 << ch)) != 0))
+            host_violation = "deadline queue does not match running countdowns";
+    }
+    for (i = 1; !host_violation && i < _timer_queue_len; i++)
+        if ((int)(_timer_mark[_timer_queue[i]] - _timer_mark[_timer_queue[i - 1]]) < 0)
+            host_violation = "deadline queue not sorted";
+
+    return host_violation != 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * Host build of the firmware: I2C master and Timer_A emulation
+ *
+ * No license applied. Use as you wish.
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#define HOST_ADDR_W     (0x41 << 1)         // Slave address for write, P1.3 high
+#define HOST_ADDR_R     ((0x41 << 1) | 1)   // Slave address for read
+
+extern unsigned long host_ccr1_count;       // Number of TACCR1 interrupts served
+extern const char * host_violation;         // First invariant broken, 0 if none
+
+void host_reset();
+
+/* Bus level operations, as seen by the master */
+void i2c_start();
+void i2c_stop();
+unsigned char i2c_write(unsigned char byte);    // Returns 0 on ACK
+unsigned char i2c_read(unsigned char nack);
+
+/* Register level transactions */
+unsigned char i2c_write_regs(unsigned char offset, const unsigned char * data, unsigned char n);
+void i2c_read_regs(unsigned char offset, unsigned char * data, unsigned char n);
+
+/* Time */
+void host_tick();
+void host_run_cycles(unsigned long cycles);    // Stops between events
+void host_run_seconds(unsigned long seconds);
+
+/* Invariants, returns 0 when all hold */
+int host_check();
+
+#endif /* HOST_H_ */
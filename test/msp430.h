@@ -0,0 +1,71 @@
+/*
+ * Host stub of <msp430.h> for building the firmware on a PC
+ *
+ * Peripheral registers are plain variables defined in host.c,
+ * bit values follow msp430g2452.h.
+ * 16-bit registers are unsigned short so they wrap as on the target.
+ * Firmware sources are built with -Dlong=int for a 32-bit long.
+ *
+ * No license applied. Use as you wish.
+ */
+
+#ifndef MSP430_H_
+#define MSP430_H_
+
+#define __interrupt
+#define _BIS_SR(x)
+#define _BIC_SR_IRQ(x)
+#define __enable_interrupt()
+#define __disable_interrupt()
+
+#define BIT0        0x0001
+#define BIT1        0x0002
+#define BIT2        0x0004
+#define BIT3        0x0008
+#define BIT4        0x0010
+#define BIT5        0x0020
+#define BIT6        0x0040
+#define BIT7        0x0080
+
+#define GIE         0x0008
+#define LPM3_bits   0x00D0
+
+/* Watchdog, clock, ports */
+extern volatile unsigned short WDTCTL;
+#define WDTPW       0x5A00
+#define WDTHOLD     0x0080
+
+extern volatile unsigned char BCSCTL1, BCSCTL3, DCOCTL;
+extern volatile unsigned char CALBC1_1MHZ, CALDCO_1MHZ;
+#define XCAP_3      0x0C
+
+extern volatile unsigned char P1IN, P1OUT, P1DIR, P1REN;
+extern volatile unsigned char P2IN, P2OUT, P2DIR, P2REN;
+
+/* Timer0_A3 */
+extern volatile unsigned short TACTL, TAR, TA0IV;
+extern volatile unsigned short TACCTL0, TACCTL1, TACCR0, TACCR1;
+#define TAIFG       0x0001
+#define TAIE        0x0002
+#define MC_2        0x0020
+#define TASSEL_1    0x0100
+#define CCIFG       0x0001
+#define CCIE        0x0010
+#define TA0IV_TACCR1    0x0002
+#define TA0IV_TAIFG     0x000A
+
+/* USI */
+extern volatile unsigned char USICTL0, USICTL1, USICKCTL, USICNT, USISRL;
+#define USISWRST    0x01
+#define USIOE       0x02
+#define USIPE6      0x40
+#define USIPE7      0x80
+#define USIIFG      0x01
+#define USISTTIFG   0x02
+#define USISTP      0x04
+#define USIIE       0x10
+#define USISTTIE    0x20
+#define USII2C      0x40
+#define USICKPL     0x02
+
+#endif /* MSP430_H_ */
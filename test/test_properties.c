@@ -0,0 +1,351 @@
+/*
+ * Property tests of the I2C register protocol and timing services
+ *
+ * No license applied. Use as you wish.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <msp430.h>
+
+#include "host.h"
+
+extern unsigned char _DATA_STORE[31];
+extern unsigned char _SCRATCHPAD[];
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: %s: CHECK(%s) failed\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#define CHECK_INVARIANTS() do { \
+        if (host_check()) { \
+            printf("%s:%d: %s: %s\n", __FILE__, __LINE__, __func__, host_violation); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * Write time registers 0~7 and let the firmware apply them after STOP
+ */
+static unsigned char set_time(unsigned char offset, const unsigned char * time, unsigned char n) {
+    unsigned char acked = i2c_write_regs(offset, time, n);
+    host_tick();                    // Buffered time is applied on the next tick
+    return acked;
+}
+
+static void test_time_roundtrip() {
+    const unsigned char time[8] = {0x10, 0x59, 0x23, 0x07, 0x31, 0x12, 0x99, 0x20};
+    unsigned char read[8];
+
+    host_reset();
+    CHECK(set_time(0, time, 8) == 8);
+    i2c_read_regs(0, read, 8);
+    CHECK(read[0] == 0x10 || read[0] == 0x11);
+    CHECK(!memcmp(read + 1, time + 1, 7));
+    CHECK_INVARIANTS();
+}
+
+static void test_date_not_in_month_rejected() {
+    const unsigned char feb = 0x02, date_31 = 0x31, date_30 = 0x30, date_29 = 0x29;
+    const unsigned char year_21 = 0x21;
+
+    // Month first, then a date February does not have
+    host_reset();
+    set_time(5, &feb, 1);
+    CHECK(_DATA_STORE[5] == 0x02);
+    set_time(4, &date_31, 1);
+    CHECK(_DATA_STORE[4] == 0x01);
+    set_time(4, &date_30, 1);
+    CHECK(_DATA_STORE[4] == 0x01);
+    CHECK_INVARIANTS();
+
+    // Feb 29 only in a leap year, year 2000 is a leap year
+    set_time(4, &date_29, 1);
+    CHECK(_DATA_STORE[4] == 0x29);
+    set_time(6, &year_21, 1);
+    CHECK(_DATA_STORE[6] == 0x00);
+    CHECK_INVARIANTS();
+
+    // The date keeps rolling over correctly afterwards
+    host_run_seconds(3L * 24 * 3600);
+    CHECK(_DATA_STORE[4] == 0x03 && _DATA_STORE[5] == 0x03);
+    CHECK_INVARIANTS();
+}
+
+static void test_month_end_rollover() {
+    const unsigned char leap[7] = {0x58, 0x59, 0x23, 0x06, 0x28, 0x02, 0x20};
+    const unsigned char common[7] = {0x58, 0x59, 0x23, 0x07, 0x28, 0x02, 0x21};
+    const unsigned char april[7] = {0x58, 0x59, 0x23, 0x04, 0x30, 0x04, 0x21};
+
+    host_reset();
+    set_time(0, leap, 7);
+    host_run_seconds(3);
+    CHECK(_DATA_STORE[4] == 0x29 && _DATA_STORE[5] == 0x02);
+    CHECK_INVARIANTS();
+
+    host_reset();
+    set_time(0, common, 7);
+    host_run_seconds(3);
+    CHECK(_DATA_STORE[4] == 0x01 && _DATA_STORE[5] == 0x03);
+    CHECK_INVARIANTS();
+
+    host_reset();
+    set_time(0, april, 7);
+    host_run_seconds(3);
+    CHECK(_DATA_STORE[4] == 0x01 && _DATA_STORE[5] == 0x05);
+    CHECK_INVARIANTS();
+}
+
+static void test_nack_mid_burst_applies_nothing() {
+    const unsigned char time[8] = {0x30, 0x30, 0x12, 0x03, 0x3A, 0x06, 0x24, 0x20};
+
+    host_reset();
+    CHECK(set_time(0, time, 8) == 4);   // Date is not BCD, NACKed
+    CHECK(_DATA_STORE[1] == 0x00 && _DATA_STORE[2] == 0x00 && _DATA_STORE[3] == 0x06);
+    CHECK_INVARIANTS();
+}
+
+static void test_flags_only_cleared_by_master() {
+    const unsigned char ones = 0xFF, zero = 0x00;
+
+    host_reset();
+    i2c_write_regs(30, &ones, 1);
+    i2c_write_regs(20, &ones, 1);
+    CHECK(_DATA_STORE[30] == 0x00 && _DATA_STORE[20] == 0x00);
+
+    _DATA_STORE[30] = 0x05;
+    i2c_write_regs(30, &ones, 1);
+    CHECK(_DATA_STORE[30] == 0x05);
+    i2c_write_regs(30, &zero, 1);
+    CHECK(_DATA_STORE[30] == 0x00);
+    CHECK_INVARIANTS();
+}
+
+static void test_unmapped_offsets() {
+    unsigned char data[16], read[16], store[31];
+    unsigned int offset;
+
+    host_reset();
+    memset(data, 0xA5, sizeof(data));
+    memcpy(store, _DATA_STORE, sizeof(store));
+    for (offset = 31; offset < 0x40; offset += 16)
+        CHECK(i2c_write_regs(offset, data, 16) == 0);   // NACKed
+    for (offset = 0x80; offset < 0x100; offset += 16)
+        CHECK(i2c_write_regs(offset, data, 16) == 0);
+    CHECK(!memcmp(store, _DATA_STORE, sizeof(store)));
+    CHECK(i2c_write_regs(0x7C, data, 16) == 4);         // Cut off at scratchpad end
+
+    i2c_read_regs(31, read, 16);
+    CHECK(read[0] == 0xFF && read[15] == 0xFF);
+    i2c_read_regs(0xF8, read, 16);      // Offset wraps to 0 after 0xFF
+    CHECK(read[7] == 0xFF && read[8] == _DATA_STORE[0]);
+    CHECK_INVARIANTS();
+}
+
+static void test_scratchpad_burst() {
+    unsigned char data[64], read[64];
+    unsigned char i;
+
+    host_reset();
+    for (i = 0; i < 64; i++)
+        data[i] = i * 7 + 3;
+    CHECK(i2c_write_regs(0x40, data, 64) == 64);
+    CHECK(i2c_write_regs(0x7F, data, 2) == 1);          // Data past the end is NACKed
+    data[63] = data[0];
+    i2c_read_regs(0x40, read, 64);
+    CHECK(!memcmp(data, read, 64));
+    CHECK(!memcmp(data, _SCRATCHPAD, 64));
+    CHECK_INVARIANTS();
+}
+
+static void test_repeated_start_mid_byte() {
+    unsigned char byte = 0x5A, read;
+
+    host_reset();
+    i2c_start();
+    i2c_write(HOST_ADDR_W);
+    i2c_write(0x40);
+    i2c_start();                    // Slave is waiting for a data byte
+    i2c_write(HOST_ADDR_W);
+    i2c_write(0x41);
+    i2c_write(byte);
+    i2c_stop();
+    CHECK(_SCRATCHPAD[0] == 0x00 && _SCRATCHPAD[1] == 0x5A);
+
+    i2c_read_regs(0x41, &read, 1);
+    CHECK(read == 0x5A);
+    CHECK_INVARIANTS();
+}
+
+static void test_nack_mid_burst_read() {
+    unsigned char data[4] = {1, 2, 3, 4}, read[2];
+
+    host_reset();
+    i2c_write_regs(0x40, data, 4);
+    i2c_start();
+    i2c_write(HOST_ADDR_W);
+    i2c_write(0x40);
+    i2c_start();
+    i2c_write(HOST_ADDR_R);
+    CHECK(i2c_read(1) == 1);        // NACK after the 1st byte ends the read
+    CHECK(i2c_read(0) == 0xFF);     // Slave released the bus
+    i2c_stop();
+
+    i2c_read_regs(0x42, read, 2);
+    CHECK(read[0] == 3 && read[1] == 4);
+    CHECK_INVARIANTS();
+}
+
+static void test_countdown_fires() {
+    const unsigned char enable = 0x01, mode = 0x01, run = 0x01, sel = 0x00, clear = 0x00;
+    const unsigned char value[2] = {16, 0};     // 1s
+    unsigned long ticks = 0;
+
+    host_reset();
+    i2c_write_regs(18, &mode, 1);
+    i2c_write_regs(19, &enable, 1);
+    i2c_write_regs(21, &sel, 1);
+    i2c_write_regs(22, value, 2);
+    i2c_write_regs(17, &run, 1);
+    while (!(_DATA_STORE[20] & BIT0) && ticks < 100) {
+        host_tick();
+        ticks++;
+        CHECK_INVARIANTS();
+    }
+    CHECK(_DATA_STORE[20] == 0x01 && _DATA_STORE[17] == 0x00);
+    CHECK(host_ccr1_count == 1);
+    CHECK(P1OUT & BIT4);
+
+    i2c_write_regs(20, &clear, 1);
+    host_tick();
+    CHECK(!(P1OUT & BIT4));
+    CHECK_INVARIANTS();
+}
+
+static void test_wakeups_follow_events() {
+    const unsigned char mode = 0x0F, run = 0x0F;
+    unsigned char ch, value[2] = {0, 0};
+
+    host_reset();
+    i2c_write_regs(18, &mode, 1);
+    for (ch = 0; ch < 4; ch++) {        // 0.25s, 0.5s, 0.75s, 1s
+        value[0] = (ch + 1) * 4;
+        i2c_write_regs(21, &ch, 1);
+        i2c_write_regs(22, value, 2);
+    }
+    i2c_write_regs(17, &run, 1);
+    host_run_seconds(2);
+    CHECK(_DATA_STORE[20] == 0x0F);
+    CHECK(host_ccr1_count == 4);
+    CHECK_INVARIANTS();
+}
+
+static void test_long_deadline_single_wakeup() {
+    const unsigned char mode = 0x01, run = 0x01, sel = 0x00;
+    const unsigned char value[2] = {0x00, 0x04};    // 1024 units, 64s
+
+    host_reset();
+    i2c_write_regs(18, &mode, 1);
+    i2c_write_regs(21, &sel, 1);
+    i2c_write_regs(22, value, 2);
+    i2c_write_regs(17, &run, 1);
+    host_run_seconds(63);
+    CHECK(_DATA_STORE[20] == 0x00 && host_ccr1_count == 0);
+    host_run_seconds(2);
+    CHECK(_DATA_STORE[20] == 0x01);
+    CHECK(host_ccr1_count == 1);
+    CHECK_INVARIANTS();
+}
+
+static void test_stopwatch_pause_keeps_fraction() {
+    const unsigned char run = 0x01, stop = 0x00, sel = 0x00;
+    unsigned char read[2], i;
+
+    host_reset();
+    i2c_write_regs(21, &sel, 1);
+    host_run_cycles(1234);              // Not aligned to a unit or a tick
+    for (i = 0; i < 15; i++) {
+        i2c_write_regs(17, &run, 1);
+        host_run_cycles(3000);
+        i2c_write_regs(17, &stop, 1);
+        host_run_cycles(777);           // Stopped time does not count
+    }
+    i2c_read_regs(22, read, 2);
+    CHECK(read[0] == 45000 / 2048 && read[1] == 0);
+    CHECK_INVARIANTS();
+}
+
+static void test_countdown_pause_keeps_fraction() {
+    const unsigned char mode = 0x01, run = 0x01, stop = 0x00, sel = 0x00;
+    const unsigned char value[2] = {32, 0};     // 2s, 65536 cycles
+    unsigned char read[2], i;
+
+    host_reset();
+    i2c_write_regs(18, &mode, 1);
+    i2c_write_regs(21, &sel, 1);
+    i2c_write_regs(22, value, 2);
+    host_run_cycles(1234);
+    for (i = 0; i < 10; i++) {
+        i2c_write_regs(17, &run, 1);
+        host_run_cycles(3000);
+        i2c_write_regs(17, &stop, 1);
+        host_run_cycles(777);
+    }
+    i2c_read_regs(22, read, 2);
+    CHECK(read[0] == (35536 + 2047) / 2048 && read[1] == 0);    // Rounded up
+
+    i2c_write_regs(17, &run, 1);
+    host_run_cycles(35535);
+    CHECK(_DATA_STORE[20] == 0x00);
+    host_run_cycles(1);
+    CHECK(_DATA_STORE[20] == 0x01);
+    CHECK_INVARIANTS();
+}
+
+static void test_stopwatch_saturates() {
+    const unsigned char run = 0x01, sel = 0x00;
+    unsigned char read[2];
+
+    host_reset();
+    i2c_write_regs(21, &sel, 1);
+    i2c_write_regs(17, &run, 1);
+    host_run_seconds(10);
+    i2c_read_regs(22, read, 2);
+    CHECK(read[0] == 160 && read[1] == 0);
+
+    host_run_seconds(37L * 3600);      // Beyond the 32-bit ACLK time base
+    i2c_read_regs(22, read, 2);
+    CHECK(read[0] == 0xFF && read[1] == 0xFF);
+    CHECK_INVARIANTS();
+}
+
+int main() {
+    test_time_roundtrip();
+    test_date_not_in_month_rejected();
+    test_month_end_rollover();
+    test_nack_mid_burst_applies_nothing();
+    test_flags_only_cleared_by_master();
+    test_unmapped_offsets();
+    test_scratchpad_burst();
+    test_repeated_start_mid_byte();
+    test_nack_mid_burst_read();
+    test_countdown_fires();
+    test_wakeups_follow_events();
+    test_long_deadline_single_wakeup();
+    test_stopwatch_pause_keeps_fraction();
+    test_countdown_pause_keeps_fraction();
+    test_stopwatch_saturates();
+
+    if (failures) {
+        printf("test_properties: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_properties: all passed\n");
+    return 0;
+}